@@ -0,0 +1,217 @@
+#include "archive.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
+
+// PATH_CAPACITY bounds the length of paths built by this module.
+#define PATH_CAPACITY 4096
+
+// Read_u32 reads a little-endian integer from the archive, independent of
+// the host's byte order and of alignment.
+static uint32_t read_u32(const void *p) {
+    const unsigned char *b = (const unsigned char *)p;
+    return (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 |
+           (uint32_t)b[3] << 24;
+}
+
+// Map_file maps the whole file at `path` read-only, filling in `base`, `size`
+// and `handle`.
+static bool map_file(archive_t *archive, const char *path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    CloseHandle(file);
+
+    if (mapping == NULL)
+        return false;
+
+    archive->base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (archive->base == NULL) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    archive->size = (size_t)size.QuadPart;
+    archive->handle = mapping;
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if (base == MAP_FAILED)
+        return false;
+
+    archive->base = base;
+    archive->size = (size_t)st.st_size;
+    return true;
+#endif
+}
+
+static void unmap_file(archive_t *archive) {
+#ifdef _WIN32
+    UnmapViewOfFile(archive->base);
+    CloseHandle(archive->handle);
+#else
+    munmap((void *)archive->base, archive->size);
+#endif
+}
+
+// Span_valid returns true if `length` bytes at `offset`, plus the NUL that
+// follows them, lie within the archive.
+static bool span_valid(const archive_t *archive, uint32_t offset,
+                       uint32_t length) {
+    uint64_t end = (uint64_t)offset + length;
+    return end < archive->size && archive->base[end] == '\0';
+}
+
+// Index_valid checks the header and every entry so lookups can trust them.
+static bool index_valid(archive_t *archive) {
+    if (archive->size < sizeof(archive_header_t))
+        return false;
+
+    const archive_header_t *header = (const archive_header_t *)archive->base;
+    if (memcmp(header->magic, ARCHIVE_MAGIC, 4) != 0 ||
+        read_u32(&header->version) != ARCHIVE_VERSION)
+        return false;
+
+    uint32_t count = read_u32(&header->count);
+    uint64_t index_end = sizeof(archive_header_t) +
+                         (uint64_t)count * sizeof(archive_entry_t);
+    if (index_end > archive->size)
+        return false;
+
+    archive->entries =
+        (const archive_entry_t *)(archive->base + sizeof(archive_header_t));
+    archive->count = count;
+
+    for (uint32_t i = 0; i < archive->count; i++) {
+        const archive_entry_t *entry = archive->entries + i;
+        if (!span_valid(archive, read_u32(&entry->name_offset),
+                        read_u32(&entry->name_length)) ||
+            !span_valid(archive, read_u32(&entry->data_offset),
+                        read_u32(&entry->data_length)))
+            return false;
+    }
+
+    return true;
+}
+
+bool archive_open(archive_t *archive, const char *path) {
+    memset(archive, 0, sizeof(archive_t));
+
+    if (!map_file(archive, path))
+        return false;
+
+    if (!index_valid(archive)) {
+        archive_close(archive);
+        return false;
+    }
+
+    return true;
+}
+
+const char *archive_find(const archive_t *archive, const char *name,
+                         size_t *length) {
+    uint32_t lo = 0;
+    uint32_t hi = archive->count;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const archive_entry_t *entry = archive->entries + mid;
+
+        int cmp = strcmp(name, archive->base + read_u32(&entry->name_offset));
+        if (cmp == 0) {
+            if (length != NULL)
+                *length = read_u32(&entry->data_length);
+            return archive->base + read_u32(&entry->data_offset);
+        }
+
+        if (cmp < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    return NULL;
+}
+
+// Executable_path writes the resolved path of the running executable to
+// `path`. It falls back to `argv0` where the platform can't say.
+static void executable_path(char *path, size_t size, const char *argv0) {
+    path[0] = '\0';
+
+#if defined(_WIN32)
+    DWORD len = GetModuleFileNameA(NULL, path, (DWORD)size);
+    if (len == 0 || len >= size)
+        path[0] = '\0';
+#elif defined(__APPLE__)
+    char link[PATH_CAPACITY];
+    uint32_t link_size = sizeof(link);
+    char resolved[PATH_MAX];
+    if (_NSGetExecutablePath(link, &link_size) == 0 &&
+        realpath(link, resolved) != NULL)
+        snprintf(path, size, "%s", resolved);
+#elif defined(__linux__)
+    ssize_t len = readlink("/proc/self/exe", path, size - 1);
+    path[len > 0 ? len : 0] = '\0';
+#endif
+
+    if (path[0] == '\0' && argv0 != NULL)
+        snprintf(path, size, "%s", argv0);
+}
+
+bool archive_open_beside_executable(archive_t *archive, const char *argv0) {
+    char exe[PATH_CAPACITY];
+    executable_path(exe, sizeof(exe), argv0);
+
+    const char *sep = strrchr(exe, '/');
+    const char *win_sep = strrchr(exe, '\\');
+    if (win_sep != NULL && (sep == NULL || win_sep > sep))
+        sep = win_sep;
+
+    char path[PATH_CAPACITY];
+    int dir_len = sep != NULL ? (int)(sep - exe) + 1 : 0;
+    int n = snprintf(path, sizeof(path), "%.*s%s", dir_len, exe, ARCHIVE_NAME);
+    if (n < 0 || n >= (int)sizeof(path))
+        return false;
+
+    return archive_open(archive, path);
+}
+
+void archive_close(archive_t *archive) {
+    if (archive->base != NULL)
+        unmap_file(archive);
+    memset(archive, 0, sizeof(archive_t));
+}
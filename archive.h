@@ -0,0 +1,66 @@
+#ifndef RAYTRIS_ARCHIVE_H_
+#define RAYTRIS_ARCHIVE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ARCHIVE_MAGIC identifies a packed resource archive, as written by `rtpack`.
+#define ARCHIVE_MAGIC "RTPK"
+
+// ARCHIVE_VERSION is bumped whenever the archive layout changes.
+#define ARCHIVE_VERSION 1
+
+// ARCHIVE_NAME is the file name of the archive, placed next to the binary.
+#define ARCHIVE_NAME "raytris.pak"
+
+// Archive_header begins every archive. It is followed by `count` entries
+// sorted by name, then by the names and contents of the packed files. All
+// integers are stored little-endian.
+typedef struct archive_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+} archive_header_t;
+
+// Archive_entry locates one packed file. Offsets are from the start of the
+// archive. Names and contents are each followed by a NUL byte that is not
+// counted in their length, so they can be used as C strings in place.
+typedef struct archive_entry {
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t data_offset;
+    uint32_t data_length;
+} archive_entry_t;
+
+// Archive is a resource archive mapped into memory.
+typedef struct archive {
+    const char *base;
+    size_t size;
+
+    const archive_entry_t *entries;
+    uint32_t count;
+
+    void *handle;
+} archive_t;
+
+// Archive_open maps the archive at `path` into memory and checks its index. It
+// returns false if the file is missing or malformed.
+bool archive_open(archive_t *archive, const char *path);
+
+// Archive_open_beside_executable opens ARCHIVE_NAME from the directory of the
+// running executable, following symlinks. `Argv0` is only used on platforms
+// where the executable's path can't be queried.
+bool archive_open_beside_executable(archive_t *archive, const char *argv0);
+
+// Archive_find returns the contents of the packed file `name`, or NULL if
+// there is no such file. The returned string points into the mapping and is
+// valid until `archive_close`. If `length` is not NULL, it receives the size
+// of the file.
+const char *archive_find(const archive_t *archive, const char *name,
+                         size_t *length);
+
+// Archive_close unmaps an archive opened with `archive_open`.
+void archive_close(archive_t *archive);
+
+#endif
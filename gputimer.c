@@ -0,0 +1,83 @@
+#include "gputimer.h"
+
+#include <string.h>
+
+// Timer queries are core in OpenGL 3.3. Raylib loads them through glad, so on
+// that backend the function pointers it loaded can be used directly.
+#if defined(GRAPHICS_API_OPENGL_33)
+#include <external/glad.h>
+#define HAS_TIMER_QUERIES
+#endif
+
+bool gpu_timer_init(gpu_timer_t *timer) {
+    memset(timer, 0, sizeof(gpu_timer_t));
+    timer->ms = -1.0f;
+
+#ifdef HAS_TIMER_QUERIES
+    if (glGenQueries == NULL)
+        return false;
+
+    glGenQueries(GPU_TIMER_FRAMES, timer->queries);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void gpu_timer_begin(gpu_timer_t *timer) {
+#ifdef HAS_TIMER_QUERIES
+    if (timer->queries[0] == 0)
+        return;
+
+    int slot = timer->frame % GPU_TIMER_FRAMES;
+    unsigned int query = timer->queries[slot];
+
+    if (timer->pending[slot]) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        // Reusing a query whose result isn't ready would stall, so skip
+        // measuring this frame instead.
+        if (!available)
+            return;
+
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+        timer->pending[slot] = false;
+
+        float ms = (float)ns / 1e6f;
+        if (timer->ms < 0.0f) {
+            timer->ms = ms;
+        } else {
+            timer->ms += (ms - timer->ms) * 0.1f;
+        }
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    timer->active = true;
+#else
+    (void)timer;
+#endif
+}
+
+void gpu_timer_end(gpu_timer_t *timer) {
+#ifdef HAS_TIMER_QUERIES
+    if (!timer->active)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    timer->pending[timer->frame % GPU_TIMER_FRAMES] = true;
+    timer->frame++;
+    timer->active = false;
+#else
+    (void)timer;
+#endif
+}
+
+void gpu_timer_free(gpu_timer_t *timer) {
+#ifdef HAS_TIMER_QUERIES
+    if (timer->queries[0] != 0)
+        glDeleteQueries(GPU_TIMER_FRAMES, timer->queries);
+#endif
+    memset(timer, 0, sizeof(gpu_timer_t));
+}
@@ -0,0 +1,40 @@
+#ifndef RAYTRIS_GPUTIMER_H_
+#define RAYTRIS_GPUTIMER_H_
+
+#include <stdbool.h>
+
+// GPU_TIMER_FRAMES is how many frames of queries a timer keeps in flight.
+// Results are read back this many frames late, by which point they are
+// normally ready, so the CPU never waits on the GPU.
+#define GPU_TIMER_FRAMES 3
+
+// Gpu_timer measures how long the GPU spends on the commands issued between
+// `gpu_timer_begin` and `gpu_timer_end`, using OpenGL timer queries. Timers
+// can't be nested.
+typedef struct gpu_timer {
+    unsigned int queries[GPU_TIMER_FRAMES];
+    bool pending[GPU_TIMER_FRAMES];
+    int frame;
+    bool active;
+
+    // Ms is the smoothed GPU time in milliseconds, or negative if nothing has
+    // been measured yet.
+    float ms;
+} gpu_timer_t;
+
+// Gpu_timer_init creates the timer's queries. It returns false if timer
+// queries aren't available, in which case the other functions do nothing.
+bool gpu_timer_init(gpu_timer_t *timer);
+
+// Gpu_timer_begin collects the oldest result, if it is ready, and starts
+// timing. Any pending raylib batch should be flushed first.
+void gpu_timer_begin(gpu_timer_t *timer);
+
+// Gpu_timer_end stops timing. Raylib's batch should be flushed first so the
+// timed draws are actually issued.
+void gpu_timer_end(gpu_timer_t *timer);
+
+// Gpu_timer_free deletes the timer's queries.
+void gpu_timer_free(gpu_timer_t *timer);
+
+#endif
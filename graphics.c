@@ -60,35 +60,170 @@ void draw_bag(struct game *game, int x, int y) {
     }
 }
 
-void draw_game(game_t *game, double time) {
-    int board_width_px = BLOCK_SIZE * BOARD_WIDTH;
-    int x = (600 - board_width_px) / 2;
-    int y = (800 - BLOCK_SIZE * BOARD_VISIBLE) / 2;
+// BG_SCALES lists the resolutions the background pass can render at, relative
+// to the screen. Scale levels index into this list, from sharpest to cheapest.
+static const float BG_SCALES[] = {1.0f, 0.75f, 0.5f, 0.25f};
+#define BG_SCALE_LEVELS ((int)(sizeof(BG_SCALES) / sizeof(BG_SCALES[0])))
+
+// BG_SETTLE_TIME is how long (in seconds) the background pass keeps a scale
+// before it is reconsidered, so measurements reflect the new resolution.
+#define BG_SETTLE_TIME 1.0
+
+// BG_PROBE_TIME is how long (in seconds) frames have to stay within budget
+// before the background pass tries a sharper scale again. A probed scale that
+// lasts this long without going over budget is kept.
+#define BG_PROBE_TIME 10.0
+
+// BG_OVER_FRAMES is how many consecutive frames the smoothed frame time has to
+// stay over budget before the scale drops. A single stall, like a shader
+// compile or a window drag, shouldn't count as the scale being too expensive.
+#define BG_OVER_FRAMES 60
+
+// Update_bg_scale picks the background scale level from the smoothed frame
+// time. Levels drop once the budget has been exceeded for a while and climb
+// back slowly.
+//
+// Frame time includes the wait for the target frame rate, so it can't show how
+// much headroom is left. Instead, a sharper level is probed, and if it goes
+// over budget before BG_PROBE_TIME it is not tried again.
+static void update_bg_scale(game_t *game, double time) {
+    struct bg_pass *pass = &game->bg_pass;
+    float budget = (float)game->settings.frame_budget;
+
+    pass->frame_time += (GetFrameTime() - pass->frame_time) * 0.1f;
+
+    if (pass->frame_time > budget * 1.1f) {
+        pass->over_frames++;
+    } else {
+        pass->over_frames = 0;
+    }
+
+    double held = time - pass->level_changed;
+    if (held < BG_SETTLE_TIME)
+        return;
+
+    if (pass->probing && held >= BG_PROBE_TIME) {
+        pass->probing = false;
+    }
+
+    int level = pass->scale_level;
+    if (pass->over_frames >= BG_OVER_FRAMES && level < BG_SCALE_LEVELS - 1) {
+        if (pass->probing) {
+            pass->sharpest_level = level + 1;
+            pass->probing = false;
+        }
+
+        pass->scale_level++;
+    } else if (pass->frame_time < budget * 1.02f &&
+               level > pass->sharpest_level && held >= BG_PROBE_TIME) {
+        pass->scale_level--;
+        pass->probing = true;
+    }
+
+    if (pass->scale_level != level) {
+        pass->level_changed = time;
+        pass->over_frames = 0;
+        game->shader_info.uniforms_dirty = true;
+    }
+}
 
+// Render_background updates the background shader's uniforms and, when the
+// background runs at reduced resolution, renders it into the smaller target.
+// It has to run before anything else is drawn to the frame, since raylib can't
+// nest render targets.
+static void render_background(game_t *game, double time) {
     Shader bg = game->bg_shader;
-    if (bg.id != 0) {
-        struct shader_info info = game->shader_info;
+    struct shader_info *info = &game->shader_info;
+    struct bg_pass *pass = &game->bg_pass;
+
+    update_bg_scale(game, time);
+
+    float scale = BG_SCALES[pass->scale_level];
+    int width = (int)(SCREEN_WIDTH * scale);
+    int height = (int)(SCREEN_HEIGHT * scale);
+
+    if (info->uniforms_dirty) {
+        // Gl_FragCoord is in target pixels, so sizes are given in those too.
+        Vector2 resolution = {(float)width, (float)height};
+        int size = (int)(BLOCK_SIZE * scale);
 
-        int size = BLOCK_SIZE;
-        float f_time = (float)time;
-        float height_percent = (float)info.approx_height / BOARD_VISIBLE;
+        SetShaderValue(bg, info->resolution_loc, &resolution,
+                       SHADER_UNIFORM_VEC2);
+        SetShaderValue(bg, info->block_size_loc, &size, SHADER_UNIFORM_INT);
+        info->uniforms_dirty = false;
+    }
+
+    float f_time = (float)time;
+    float height_percent = (float)info->approx_height / BOARD_VISIBLE;
+
+    float over_time = 0;
+    if (game->over) {
+        over_time = (float)time - info->over_time;
+    }
 
-        float over_time = 0;
-        if (game->over) {
-            over_time = (float)time - info.over_time;
+    SetShaderValue(bg, info->time_loc, &f_time, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(bg, info->over_time_loc, &over_time, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(bg, info->height_loc, &height_percent, SHADER_UNIFORM_FLOAT);
+
+    // At full resolution the shader is drawn straight into the frame by
+    // draw_background, so the target isn't needed.
+    if (scale == 1.0f) {
+        if (pass->target.id != 0) {
+            UnloadRenderTexture(pass->target);
+            pass->target = (RenderTexture2D){0};
         }
+        return;
+    }
 
-        Vector2 resolution = {600, 800};
+    if (pass->target.id == 0 || pass->target.texture.width != width) {
+        if (pass->target.id != 0)
+            UnloadRenderTexture(pass->target);
+
+        pass->target = LoadRenderTexture(width, height);
+        SetTextureFilter(pass->target.texture, TEXTURE_FILTER_BILINEAR);
+    }
 
-        SetShaderValue(bg, info.resolution_loc, &resolution, SHADER_UNIFORM_VEC2);
-        SetShaderValue(bg, info.time_loc, &f_time, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(bg, info.over_time_loc, &over_time, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(bg, info.height_loc, &height_percent, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(bg, info.block_size_loc, &size, SHADER_UNIFORM_INT);
+    BeginTextureMode(pass->target);
+    BeginShaderMode(bg);
+    DrawRectangle(0, 0, width, height, BLACK);
+    EndShaderMode();
+    EndTextureMode();
+}
 
-        BeginShaderMode(bg);
-        DrawRectangle(0, 0, 600, 800, BLACK);
+// Draw_background fills the screen with the background, either by running
+// the shader directly or by upscaling the reduced-resolution target.
+static void draw_background(game_t *game) {
+    if (game->bg_pass.target.id == 0) {
+        BeginShaderMode(game->bg_shader);
+        DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, BLACK);
         EndShaderMode();
+        return;
+    }
+
+    Texture2D texture = game->bg_pass.target.texture;
+
+    // Render textures are stored upside-down, hence the negative height.
+    DrawTexturePro(texture,
+                   (Rectangle){0, 0, (float)texture.width,
+                               (float)-texture.height},
+                   (Rectangle){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT},
+                   (Vector2){0, 0}, 0.0f, WHITE);
+}
+
+void draw_game(game_t *game, double time) {
+    int board_width_px = BLOCK_SIZE * BOARD_WIDTH;
+    int x = (SCREEN_WIDTH - board_width_px) / 2;
+    int y = (SCREEN_HEIGHT - BLOCK_SIZE * BOARD_VISIBLE) / 2;
+
+    bool has_bg = game->bg_shader.id != 0;
+    if (has_bg) {
+        render_background(game, time);
+    }
+
+    postfx_begin(&game->post, game->settings.palette.bg_color);
+
+    if (has_bg) {
+        draw_background(game);
     }
 
     DrawRectangle(x, y, board_width_px, BLOCK_SIZE * BOARD_VISIBLE,
@@ -104,4 +239,83 @@ void draw_game(game_t *game, double time) {
         draw_piece_s(&game->held, &game->settings.palette,
                      x - (2 * BLOCK_SIZE) - 16, y + 16, BLOCK_SIZE / 2);
     }
-}
\ No newline at end of file
+
+    particles_draw(&game->particles, x, y - BLOCK_SIZE * BOARD_VISIBLE,
+                   BLOCK_SIZE);
+
+    postfx_end(&game->post, time);
+}
+
+// LOCK_PARTICLES is how many particles each block of a locked piece emits.
+#define LOCK_PARTICLES 3
+
+// CLEAR_PARTICLES is how many particles each block of a cleared line emits.
+#define CLEAR_PARTICLES 12
+
+void animate_game(game_t *game, double time) {
+    game_events_t *events = &game->events;
+    palette_t *palette = &game->settings.palette;
+
+    if (events->locked) {
+        tetromino_t *piece = &events->locked_piece;
+        for (int i = 0; i < piece->size; i++) {
+            for (int j = 0; j < piece->size; j++) {
+                if (piece->shape[i][j] == 0)
+                    continue;
+
+                particles_burst(&game->particles,
+                                (float)(events->locked_x + i),
+                                (float)(events->locked_y + j),
+                                palette->block_colors[piece->shape[i][j] - 1],
+                                LOCK_PARTICLES, 2.0f);
+            }
+        }
+    }
+
+    for (int r = 0; r < events->cleared_count; r++) {
+        for (int i = 0; i < BOARD_WIDTH; i++) {
+            int block = events->cleared_blocks[r][i];
+            particles_burst(&game->particles, (float)i,
+                            (float)events->cleared_rows[r],
+                            palette->block_colors[block - 1], CLEAR_PARTICLES,
+                            8.0f);
+        }
+    }
+
+    particles_update(&game->particles, time);
+}
+
+void draw_stats(game_t *game, int x, int y) {
+    postfx_t *post = &game->post;
+    int line = 0;
+
+    float frame = GetFrameTime() * 1000.0f;
+    float budget = (float)(game->settings.frame_budget * 1000.0);
+    DrawText(TextFormat("frame %.2f / %.2f ms", frame, budget), x,
+             y + 20 * line++, 20, frame > budget ? RED : WHITE);
+
+    if (game->bg_shader.id != 0) {
+        DrawText(TextFormat("background %.0f%%",
+                            BG_SCALES[game->bg_pass.scale_level] * 100.0f),
+                 x, y + 20 * line++, 20, WHITE);
+    }
+
+    // Pass times come from GPU timer queries, which some backends lack.
+    for (int i = 0; i < post->pass_count; i++) {
+        postfx_pass_t *pass = post->passes + i;
+        const char *first = post->effect_names[pass->first_effect];
+        char cost[32] = "n/a";
+        if (pass->timer.ms >= 0.0f)
+            snprintf(cost, sizeof(cost), "%.2f ms", pass->timer.ms);
+
+        DrawText(TextFormat("post %d: %s GPU (%d effects from %s)", i, cost,
+                            pass->effect_count, GetFileName(first)),
+                 x, y + 20 * line++, 20, WHITE);
+    }
+
+    float total = postfx_cost(post);
+    if (total >= 0.0f) {
+        DrawText(TextFormat("post total: %.2f ms GPU", total), x,
+                 y + 20 * line++, 20, total > budget ? RED : WHITE);
+    }
+}
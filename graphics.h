@@ -4,6 +4,9 @@
 #include "raytris.h"
 #include "settings.h"
 
+#define SCREEN_WIDTH 600
+#define SCREEN_HEIGHT 800
+
 // Draw_piece_s draws the given tetromino at (x, y) on-screen using the given
 // `block_size` and corresponding color(s) from `palette`.
 void draw_piece_s(tetromino_t *piece, palette_t *palette, int x, int y, int block_size);
@@ -18,7 +21,16 @@ void draw_board(board_t *board, palette_t *palette, int x, int y);
 // Draw_bag draws the queue of upcoming pieces at (x, y).
 void draw_bag(game_t *game, int x, int y);
 
-// Draw_game draws the entire game to the screen.
+// Draw_game draws the entire game to the screen, through the post-processing
+// chain if there is one.
 void draw_game(game_t *game, double time);
 
+// Animate_game spawns particles for the locks and line clears of the last
+// game_update, and advances all particles to `time`.
+void animate_game(game_t *game, double time);
+
+// Draw_stats draws frame timing and the cost of each post-processing pass at
+// (x, y).
+void draw_stats(game_t *game, int x, int y);
+
 #endif
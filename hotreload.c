@@ -0,0 +1,453 @@
+#include "hotreload.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Read_file reads the whole file at `path` into a NUL-terminated string.
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+        return NULL;
+
+    char *data = NULL;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        long size = ftell(f);
+        if (size >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+            data = malloc((size_t)size + 1);
+            if (data != NULL) {
+                size_t read = fread(data, 1, (size_t)size, f);
+                data[read] = '\0';
+            }
+        }
+    }
+
+    fclose(f);
+    return data;
+}
+
+// Looks_valid does a quick sanity check of shader source so that files caught
+// halfway through being saved are not handed to the GPU driver. Actual
+// compilation has to happen on the render thread.
+static bool looks_valid(const char *src) {
+    if (src[0] == '\0' || strstr(src, "main") == NULL)
+        return false;
+
+    int depth = 0;
+    for (const char *c = src; *c != '\0'; c++) {
+        if (*c == '{')
+            depth++;
+        if (*c == '}' && --depth < 0)
+            return false;
+    }
+
+    return depth == 0;
+}
+
+// Load_checked reads `path` and returns its contents if they pass
+// `looks_valid`.
+static char *load_checked(const char *path) {
+    char *src = read_file(path);
+    if (src != NULL && !looks_valid(src)) {
+        printf("Ignoring incomplete shader %s\n", path);
+        free(src);
+        src = NULL;
+    }
+
+    return src;
+}
+
+static char *copy_string(const char *s) {
+    size_t len = strlen(s) + 1;
+    char *copy = malloc(len);
+    if (copy != NULL)
+        memcpy(copy, s, len);
+    return copy;
+}
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+// The watcher thread waits on both the directory change notification and
+// `stop_event`, so it can be stopped without a timeout.
+struct hotreload {
+    char *path;
+    WCHAR file_name[MAX_PATH];
+
+    HANDLE dir;
+    HANDLE change_event;
+    HANDLE stop_event;
+    HANDLE thread;
+
+    CRITICAL_SECTION lock;
+    char *pending; // Guarded by lock
+};
+
+// Read_changes drains the notification buffer filled by ReadDirectoryChangesW
+// and returns true if any of the entries refer to the watched file. A length of
+// zero means the buffer overflowed, so the file may have changed.
+static bool read_changes(hotreload_t *h, const BYTE *buf, DWORD len) {
+    if (len == 0)
+        return true;
+
+    size_t name_len = wcslen(h->file_name);
+    bool changed = false;
+
+    for (DWORD offset = 0; offset < len;) {
+        const FILE_NOTIFY_INFORMATION *info =
+            (const FILE_NOTIFY_INFORMATION *)(buf + offset);
+        size_t len_chars = info->FileNameLength / sizeof(WCHAR);
+        if (len_chars == name_len &&
+            _wcsnicmp(info->FileName, h->file_name, name_len) == 0 &&
+            info->Action != FILE_ACTION_REMOVED &&
+            info->Action != FILE_ACTION_RENAMED_OLD_NAME)
+            changed = true;
+
+        if (info->NextEntryOffset == 0)
+            break;
+        offset += info->NextEntryOffset;
+    }
+
+    return changed;
+}
+
+static DWORD WINAPI watch_thread(LPVOID user) {
+    hotreload_t *h = (hotreload_t *)user;
+    DWORD buf[1024]; // DWORD-aligned, as ReadDirectoryChangesW requires
+    HANDLE events[] = {h->change_event, h->stop_event};
+
+    for (;;) {
+        OVERLAPPED overlapped = {.hEvent = h->change_event};
+        if (!ReadDirectoryChangesW(
+                h->dir, buf, sizeof(buf), FALSE,
+                FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME,
+                NULL, &overlapped, NULL))
+            break;
+
+        DWORD waited = WaitForMultipleObjects(2, events, FALSE, INFINITE);
+        if (waited != WAIT_OBJECT_0) {
+            CancelIo(h->dir);
+            GetOverlappedResult(h->dir, &overlapped, &(DWORD){0}, TRUE);
+            break;
+        }
+
+        DWORD len;
+        if (!GetOverlappedResult(h->dir, &overlapped, &len, FALSE) ||
+            !read_changes(h, (const BYTE *)buf, len))
+            continue;
+
+        // The editor may still hold the file open right after the
+        // notification, in which case load_checked sees an incomplete file
+        // and the next write notification picks it up.
+        char *src = load_checked(h->path);
+        if (src == NULL)
+            continue;
+
+        EnterCriticalSection(&h->lock);
+        free(h->pending);
+        h->pending = src;
+        LeaveCriticalSection(&h->lock);
+    }
+
+    return 0;
+}
+
+hotreload_t *hotreload_start(const char *path) {
+    hotreload_t *h = calloc(1, sizeof(hotreload_t));
+    if (h == NULL)
+        return NULL;
+
+    h->dir = INVALID_HANDLE_VALUE;
+    h->path = copy_string(path);
+    if (h->path == NULL)
+        goto fail;
+
+    // As on Linux, the containing directory is watched so that saves which
+    // replace the file are seen too.
+    char *slash = strrchr(h->path, '/');
+    char *backslash = strrchr(h->path, '\\');
+    if (backslash != NULL && (slash == NULL || backslash > slash))
+        slash = backslash;
+
+    const char *file_name = slash != NULL ? slash + 1 : h->path;
+    if (MultiByteToWideChar(CP_ACP, 0, file_name, -1, h->file_name,
+                            MAX_PATH) == 0)
+        goto fail;
+
+    if (slash != NULL) {
+        char sep = *slash;
+        *slash = '\0';
+        h->dir = CreateFileA(slash == h->path ? "\\" : h->path,
+                             FILE_LIST_DIRECTORY,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE |
+                                 FILE_SHARE_DELETE,
+                             NULL, OPEN_EXISTING,
+                             FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                             NULL);
+        *slash = sep;
+    } else {
+        h->dir = CreateFileA(".", FILE_LIST_DIRECTORY,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE |
+                                 FILE_SHARE_DELETE,
+                             NULL, OPEN_EXISTING,
+                             FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                             NULL);
+    }
+
+    if (h->dir == INVALID_HANDLE_VALUE)
+        goto fail;
+
+    h->change_event = CreateEventA(NULL, FALSE, FALSE, NULL);
+    h->stop_event = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (h->change_event == NULL || h->stop_event == NULL)
+        goto fail;
+
+    InitializeCriticalSection(&h->lock);
+    h->thread = CreateThread(NULL, 0, watch_thread, h, 0, NULL);
+    if (h->thread == NULL) {
+        DeleteCriticalSection(&h->lock);
+        goto fail;
+    }
+
+    return h;
+
+fail:
+    if (h->stop_event != NULL)
+        CloseHandle(h->stop_event);
+    if (h->change_event != NULL)
+        CloseHandle(h->change_event);
+    if (h->dir != INVALID_HANDLE_VALUE)
+        CloseHandle(h->dir);
+    free(h->path);
+    free(h);
+    return NULL;
+}
+
+char *hotreload_take(hotreload_t *h) {
+    EnterCriticalSection(&h->lock);
+    char *src = h->pending;
+    h->pending = NULL;
+    LeaveCriticalSection(&h->lock);
+    return src;
+}
+
+void hotreload_stop(hotreload_t *h) {
+    SetEvent(h->stop_event);
+    WaitForSingleObject(h->thread, INFINITE);
+
+    CloseHandle(h->thread);
+    CloseHandle(h->stop_event);
+    CloseHandle(h->change_event);
+    CloseHandle(h->dir);
+    DeleteCriticalSection(&h->lock);
+
+    free(h->pending);
+    free(h->path);
+    free(h);
+}
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#else
+#include <sys/stat.h>
+#include <time.h>
+#endif
+
+// POLL_TIMEOUT_MS bounds how long the watcher thread takes to notice that it
+// should stop.
+#define POLL_TIMEOUT_MS 250
+
+struct hotreload {
+    char *path;
+    const char *file_name;
+
+#ifdef __linux__
+    int fd;
+#else
+    struct stat last_stat;
+#endif
+    pthread_t thread;
+
+    pthread_mutex_t lock;
+    char *pending; // Guarded by lock
+    bool stop;     // Guarded by lock
+};
+
+static bool should_stop(hotreload_t *h) {
+    pthread_mutex_lock(&h->lock);
+    bool stop = h->stop;
+    pthread_mutex_unlock(&h->lock);
+    return stop;
+}
+
+#ifdef __linux__
+
+// Read_events drains pending inotify events and returns true if any of them
+// refer to the watched file.
+static bool read_events(hotreload_t *h) {
+    char buf[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+
+    ssize_t len = read(h->fd, buf, sizeof(buf));
+    for (char *p = buf; len > 0 && p < buf + len;) {
+        struct inotify_event *event = (struct inotify_event *)p;
+        if (event->len > 0 && strcmp(event->name, h->file_name) == 0)
+            changed = true;
+        p += sizeof(struct inotify_event) + event->len;
+    }
+
+    return changed;
+}
+
+// Wait_for_change waits up to POLL_TIMEOUT_MS and returns true if the watched
+// file was written or replaced in that time.
+static bool wait_for_change(hotreload_t *h) {
+    struct pollfd pfd = {.fd = h->fd, .events = POLLIN};
+    return poll(&pfd, 1, POLL_TIMEOUT_MS) > 0 && read_events(h);
+}
+
+static bool watch_init(hotreload_t *h) {
+    h->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (h->fd < 0)
+        return false;
+
+    // Editors often save by writing a new file and renaming it over the old
+    // one, so the containing directory is watched rather than the file itself.
+    char *slash = strrchr(h->path, '/');
+    h->file_name = slash != NULL ? slash + 1 : h->path;
+
+    int wd;
+    if (slash != NULL) {
+        *slash = '\0';
+        wd = inotify_add_watch(h->fd, slash == h->path ? "/" : h->path,
+                               IN_CLOSE_WRITE | IN_MOVED_TO);
+        *slash = '/';
+    } else {
+        wd = inotify_add_watch(h->fd, ".", IN_CLOSE_WRITE | IN_MOVED_TO);
+    }
+
+    if (wd < 0) {
+        close(h->fd);
+        return false;
+    }
+
+    return true;
+}
+
+static void watch_close(hotreload_t *h) { close(h->fd); }
+
+#else
+
+// POLL_INTERVAL_MS is how often the file's status is checked where there is
+// no change notification API to wait on.
+#define POLL_INTERVAL_MS 1000
+
+// Wait_for_change sleeps for POLL_INTERVAL_MS, in POLL_TIMEOUT_MS steps so
+// that stopping stays responsive, then compares the file's status with the
+// last one seen. Comparing the inode as well catches saves that replace the
+// file within the same second.
+static bool wait_for_change(hotreload_t *h) {
+    for (int waited = 0; waited < POLL_INTERVAL_MS;
+         waited += POLL_TIMEOUT_MS) {
+        if (should_stop(h))
+            return false;
+
+        struct timespec step = {0, POLL_TIMEOUT_MS * 1000000L};
+        nanosleep(&step, NULL);
+    }
+
+    struct stat st;
+    if (stat(h->path, &st) != 0)
+        return false;
+
+    bool changed = st.st_mtime != h->last_stat.st_mtime ||
+                   st.st_size != h->last_stat.st_size ||
+                   st.st_ino != h->last_stat.st_ino;
+    h->last_stat = st;
+    return changed;
+}
+
+static bool watch_init(hotreload_t *h) {
+    return stat(h->path, &h->last_stat) == 0;
+}
+
+static void watch_close(hotreload_t *h) { (void)h; }
+
+#endif
+
+static void *watch_thread(void *user) {
+    hotreload_t *h = (hotreload_t *)user;
+
+    while (!should_stop(h)) {
+        if (!wait_for_change(h))
+            continue;
+
+        char *src = load_checked(h->path);
+        if (src == NULL)
+            continue;
+
+        pthread_mutex_lock(&h->lock);
+        free(h->pending);
+        h->pending = src;
+        pthread_mutex_unlock(&h->lock);
+    }
+
+    return NULL;
+}
+
+hotreload_t *hotreload_start(const char *path) {
+    hotreload_t *h = calloc(1, sizeof(hotreload_t));
+    if (h == NULL)
+        return NULL;
+
+    h->path = copy_string(path);
+    if (h->path == NULL || !watch_init(h)) {
+        free(h->path);
+        free(h);
+        return NULL;
+    }
+
+    pthread_mutex_init(&h->lock, NULL);
+    if (pthread_create(&h->thread, NULL, watch_thread, h) != 0) {
+        pthread_mutex_destroy(&h->lock);
+        watch_close(h);
+        free(h->path);
+        free(h);
+        return NULL;
+    }
+
+    return h;
+}
+
+char *hotreload_take(hotreload_t *h) {
+    pthread_mutex_lock(&h->lock);
+    char *src = h->pending;
+    h->pending = NULL;
+    pthread_mutex_unlock(&h->lock);
+    return src;
+}
+
+void hotreload_stop(hotreload_t *h) {
+    pthread_mutex_lock(&h->lock);
+    h->stop = true;
+    pthread_mutex_unlock(&h->lock);
+
+    pthread_join(h->thread, NULL);
+    pthread_mutex_destroy(&h->lock);
+    watch_close(h);
+
+    free(h->pending);
+    free(h->path);
+    free(h);
+}
+
+#endif
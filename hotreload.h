@@ -0,0 +1,23 @@
+#ifndef RAYTRIS_HOTRELOAD_H_
+#define RAYTRIS_HOTRELOAD_H_
+
+// Hotreload watches a single file for changes so it can be reloaded while the
+// game is running. The file is read and checked on a background thread, so
+// the calling thread only ever picks up finished results. Changes are
+// detected with inotify on Linux and ReadDirectoryChangesW on Windows; other
+// platforms poll the file's status from the background thread.
+typedef struct hotreload hotreload_t;
+
+// Hotreload_start begins watching the file at `path`. It returns NULL if the
+// file can't be watched.
+hotreload_t *hotreload_start(const char *path);
+
+// Hotreload_take returns the contents of the watched file if it has changed
+// since the last call and looks like a valid shader, or NULL otherwise. The
+// caller owns the returned string and must free() it.
+char *hotreload_take(hotreload_t *h);
+
+// Hotreload_stop stops watching and frees `h`.
+void hotreload_stop(hotreload_t *h);
+
+#endif
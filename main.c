@@ -1,44 +1,125 @@
 #include <raylib.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
+#include "archive.h"
 #include "graphics.h"
 #include "raytris.h"
+#include "recording.h"
+
+// SETTINGS_PATH is where settings are read from, either inside the resource
+// archive or relative to the working directory.
+#define SETTINGS_PATH "resources/raytris.ini"
 
 int main(int argc, char const *argv[]) {
-    InitWindow(600, 800, "raytris");
-    SetTargetFPS(60);
+    // --seed fixes the piece sequence and --record writes a recording of the
+    // run to a file. --replay plays a recording back without a window, which
+    // together with --record re-runs it on another build for comparison.
+    unsigned int seed = (unsigned int)time(NULL);
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--seed") == 0) {
+            seed = (unsigned int)strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "--record") == 0) {
+            record_path = argv[i + 1];
+        } else if (strcmp(argv[i], "--replay") == 0) {
+            replay_path = argv[i + 1];
+        }
+    }
+
+    FILE *rec = NULL;
+    if (record_path != NULL) {
+        rec = fopen(record_path, "w");
+        if (rec == NULL) {
+            printf("Failed to open %s\n", record_path);
+            return 1;
+        }
+    }
 
     game_t game = {0};
 
     settings_t settings = SETTINGS_DEFAULT;
 
     printf("Loading\n");
-    if (!settings_load(&settings, "resources/raytris.ini")) {
+
+    archive_t resources = {0};
+    int loaded;
+    if (archive_open_beside_executable(&resources,
+                                       argc > 0 ? argv[0] : NULL)) {
+        const char *ini = archive_find(&resources, SETTINGS_PATH, NULL);
+        loaded = ini != NULL && settings_load_string(&settings, ini);
+        game.resources = &resources;
+    } else {
+        printf("No %s found, using loose resources\n", ARCHIVE_NAME);
+        loaded = settings_load(&settings, SETTINGS_PATH);
+    }
+
+    if (!loaded) {
         printf("Failed to read settings\n");
         for (int i = 0; i < TM_COUNT; i++) {
             settings.palette.block_colors[i] = WHITE;
         }
     }
 
+    if (replay_path != NULL) {
+        bool replayed = recording_replay(replay_path, rec);
+        if (!replayed)
+            printf("Failed to replay %s\n", replay_path);
+
+        if (rec != NULL)
+            fclose(rec);
+        archive_close(&resources);
+        return replayed ? 0 : 1;
+    }
+
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "raytris");
+    SetTargetFPS(60);
+    if (rec != NULL)
+        recording_begin(rec, seed, &settings);
+
     game.settings = settings;
+    game_seed(&game, seed);
     game_init(&game);
 
     while (!WindowShouldClose()) {
+        game_poll_shaders(&game);
+
         double time = GetTime();
+        input_t input = game_read_input(&game);
 
-        if (!game_update(&game, time)) {
-            if (IsKeyPressed(settings.bindings.key_reset)) {
-                game_reset(&game);
-            }
+        if (game_update(&game, input, time)) {
+            if (rec != NULL)
+                recording_tick(rec, &game, input, time);
+        } else if (IsKeyPressed(settings.bindings.key_reset)) {
+            game_reset(&game);
+            particles_clear(&game.particles);
+            if (rec != NULL)
+                recording_reset(rec);
+        }
+
+        animate_game(&game, time);
+
+        if (IsKeyPressed(settings.bindings.key_stats)) {
+            game.show_stats = !game.show_stats;
         }
 
         BeginDrawing();
         ClearBackground(game.settings.palette.bg_color);
         draw_game(&game, time);
+        if (game.show_stats) {
+            draw_stats(&game, 8, 8);
+        }
         EndDrawing();
     }
 
     game_free(&game);
+    archive_close(&resources);
+    if (rec != NULL)
+        fclose(rec);
     CloseWindow();
     return 0;
 }
@@ -0,0 +1,157 @@
+// Rtpack packs resource files into a single archive that raytris maps into
+// memory at startup. See archive.h for the layout.
+//
+// Usage: rtpack <output> <file>...
+//
+// Files are stored under the paths they are given by, so it should be run from
+// the directory the game would normally be started from.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "archive.h"
+
+typedef struct packed_file {
+    char *name;
+    char *data;
+    uint32_t length;
+} packed_file_t;
+
+static char *read_file(const char *path, uint32_t *length) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+        return NULL;
+
+    char *data = NULL;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        long size = ftell(f);
+        if (size >= 0 && size < UINT32_MAX && fseek(f, 0, SEEK_SET) == 0) {
+            data = malloc((size_t)size + 1);
+            if (data != NULL &&
+                fread(data, 1, (size_t)size, f) == (size_t)size) {
+                *length = (uint32_t)size;
+            } else {
+                free(data);
+                data = NULL;
+            }
+        }
+    }
+
+    fclose(f);
+    return data;
+}
+
+// Normalize_name converts `path` to the form the game looks files up by, with
+// forward slashes and no leading "./".
+static char *normalize_name(const char *path) {
+    while (strncmp(path, "./", 2) == 0 || strncmp(path, ".\\", 2) == 0)
+        path += 2;
+
+    size_t len = strlen(path);
+    char *name = malloc(len + 1);
+    if (name == NULL)
+        return NULL;
+
+    for (size_t i = 0; i <= len; i++)
+        name[i] = path[i] == '\\' ? '/' : path[i];
+    return name;
+}
+
+static int compare_names(const void *a, const void *b) {
+    return strcmp(((const packed_file_t *)a)->name,
+                  ((const packed_file_t *)b)->name);
+}
+
+static void write_u32(FILE *f, uint32_t value) {
+    unsigned char bytes[4] = {value & 0xff, (value >> 8) & 0xff,
+                              (value >> 16) & 0xff, (value >> 24) & 0xff};
+    fwrite(bytes, 1, 4, f);
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <output> <file>...\n", argv[0]);
+        return 1;
+    }
+
+    uint32_t count = (uint32_t)(argc - 2);
+    packed_file_t *files = calloc(count > 0 ? count : 1, sizeof(packed_file_t));
+    if (files == NULL)
+        return 1;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const char *path = argv[i + 2];
+        files[i].name = normalize_name(path);
+        files[i].data = read_file(path, &files[i].length);
+        if (files[i].name == NULL || files[i].data == NULL) {
+            fprintf(stderr, "Failed to read %s\n", path);
+            return 1;
+        }
+    }
+
+    // The game looks entries up with a binary search.
+    qsort(files, count, sizeof(packed_file_t), compare_names);
+
+    for (uint32_t i = 1; i < count; i++) {
+        if (strcmp(files[i - 1].name, files[i].name) == 0) {
+            fprintf(stderr, "Duplicate file %s\n", files[i].name);
+            return 1;
+        }
+    }
+
+    FILE *out = fopen(argv[1], "wb");
+    if (out == NULL) {
+        fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return 1;
+    }
+
+    fwrite(ARCHIVE_MAGIC, 1, 4, out);
+    write_u32(out, ARCHIVE_VERSION);
+    write_u32(out, count);
+
+    uint64_t offset = sizeof(archive_header_t) +
+                      (uint64_t)count * sizeof(archive_entry_t);
+    uint64_t data_offset = offset;
+    for (uint32_t i = 0; i < count; i++)
+        data_offset += strlen(files[i].name) + 1;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t name_length = (uint32_t)strlen(files[i].name);
+        if (data_offset + files[i].length + 1 > UINT32_MAX) {
+            fprintf(stderr, "Archive too large\n");
+            fclose(out);
+            return 1;
+        }
+
+        write_u32(out, (uint32_t)offset);
+        write_u32(out, name_length);
+        write_u32(out, (uint32_t)data_offset);
+        write_u32(out, files[i].length);
+
+        offset += name_length + 1;
+        data_offset += files[i].length + 1;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+        fwrite(files[i].name, 1, strlen(files[i].name) + 1, out);
+
+    for (uint32_t i = 0; i < count; i++) {
+        fwrite(files[i].data, 1, files[i].length, out);
+        fputc('\0', out);
+    }
+
+    if (fclose(out) != 0) {
+        fprintf(stderr, "Failed to write %s\n", argv[1]);
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        free(files[i].name);
+        free(files[i].data);
+    }
+    free(files);
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "particles.h"
+
+#include "xorshift.h"
+
+// MSVC only knows C99's restrict by its own spelling in older versions.
+#if defined(_MSC_VER) && !defined(restrict)
+#define restrict __restrict
+#endif
+
+// PARTICLE_GRAVITY is the downward acceleration of particles in cells per
+// second squared.
+#define PARTICLE_GRAVITY 30.0f
+
+// PARTICLE_SIZE is the width of a particle in cells.
+#define PARTICLE_SIZE 0.2f
+
+// Next_random returns a float in [0, 1). Particles use their own generator so
+// that effects don't disturb the piece sequence.
+static float next_random(particles_t *p) {
+    return (float)(xorshift32(&p->seed) >> 8) / (float)(1u << 24);
+}
+
+void particles_clear(particles_t *p) {
+    p->count = 0;
+}
+
+void particles_burst(particles_t *p, float x, float y, Color color, int n,
+                     float speed) {
+    if (n > PARTICLES_MAX - p->count)
+        n = PARTICLES_MAX - p->count;
+
+    for (int i = p->count; i < p->count + n; i++) {
+        float life = 0.4f + 0.6f * next_random(p);
+
+        p->x[i] = x + next_random(p);
+        p->y[i] = y + next_random(p);
+        p->vx[i] = speed * (2.0f * next_random(p) - 1.0f);
+        p->vy[i] = speed * (2.0f * next_random(p) - 1.5f);
+        p->life[i] = life;
+        p->fade[i] = 1.0f / life;
+        p->color[i] = color;
+    }
+
+    p->count += n;
+}
+
+void particles_update(particles_t *p, double time) {
+    float dt = (float)(time - p->last_update);
+    p->last_update = time;
+
+    // Skip the first update and any long stall rather than teleporting
+    // particles.
+    if (dt <= 0.0f || dt > 0.25f)
+        return;
+
+    int n = p->count;
+    // The arrays never overlap. Saying so lets the compiler vectorize the loop
+    // below without runtime alias checks.
+    float *restrict x = p->x;
+    float *restrict y = p->y;
+    float *restrict vx = p->vx;
+    float *restrict vy = p->vy;
+    float *restrict life = p->life;
+
+    // This loop is branch-free so the compiler can vectorize it. CMakeLists.txt
+    // optimizes this file in every build type so that it does.
+    for (int i = 0; i < n; i++) {
+        vy[i] += PARTICLE_GRAVITY * dt;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        life[i] -= dt;
+    }
+
+    // Remove expired particles by moving the last live particle into their
+    // slot. Order doesn't matter, so this keeps the arrays dense.
+    for (int i = 0; i < n;) {
+        if (life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+
+        n--;
+        x[i] = x[n];
+        y[i] = y[n];
+        vx[i] = vx[n];
+        vy[i] = vy[n];
+        life[i] = life[n];
+        p->fade[i] = p->fade[n];
+        p->color[i] = p->color[n];
+    }
+
+    p->count = n;
+}
+
+void particles_draw(particles_t *p, int x, int y, int cell_size) {
+    Vector2 size = {PARTICLE_SIZE * cell_size, PARTICLE_SIZE * cell_size};
+
+    // All particles share the default texture and shader, so raylib draws
+    // them in a single batch.
+    for (int i = 0; i < p->count; i++) {
+        Color color = p->color[i];
+        color.a = (unsigned char)(color.a * p->life[i] * p->fade[i]);
+
+        DrawRectangleV((Vector2){x + p->x[i] * cell_size,
+                                 y + p->y[i] * cell_size},
+                       size, color);
+    }
+}
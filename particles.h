@@ -0,0 +1,47 @@
+#ifndef RAYTRIS_PARTICLES_H_
+#define RAYTRIS_PARTICLES_H_
+
+#include <raylib.h>
+#include <stdint.h>
+
+// PARTICLES_MAX is the capacity of the particle pool. Bursts that would exceed
+// it are cut short.
+#define PARTICLES_MAX 4096
+
+// Particles is a fixed-capacity pool of particles, stored as one array per
+// attribute so updates run over contiguous floats. Live particles occupy
+// indices [0, count). Positions are in board cells.
+typedef struct particles {
+    float x[PARTICLES_MAX];
+    float y[PARTICLES_MAX];
+    float vx[PARTICLES_MAX];
+    float vy[PARTICLES_MAX];
+
+    // Life is the remaining lifetime in seconds, and fade is the reciprocal of
+    // the initial lifetime, used to fade particles out.
+    float life[PARTICLES_MAX];
+    float fade[PARTICLES_MAX];
+
+    Color color[PARTICLES_MAX];
+
+    int count;
+    uint32_t seed;
+    double last_update;
+} particles_t;
+
+// Particles_clear removes all particles.
+void particles_clear(particles_t *p);
+
+// Particles_burst spawns `n` particles of `color` at (x, y), moving outward at
+// up to `speed` cells per second.
+void particles_burst(particles_t *p, float x, float y, Color color, int n,
+                     float speed);
+
+// Particles_update advances all particles to `time` and removes expired ones.
+void particles_update(particles_t *p, double time);
+
+// Particles_draw draws all particles, with board cell (0, 0) at (x, y) and
+// each cell `cell_size` pixels wide.
+void particles_draw(particles_t *p, int x, int y, int cell_size);
+
+#endif
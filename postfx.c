@@ -0,0 +1,223 @@
+#include "postfx.h"
+
+#include <rlgl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The generated shader is paired with raylib's default vertex shader, so it
+// has to be written in the same GLSL dialect as the backend raylib was built
+// for. The effect snippets themselves stick to what all of them share.
+#if defined(GRAPHICS_API_OPENGL_ES3)
+#define GLSL_HEADER                                                            \
+    "#version 300 es\n"                                                        \
+    "precision mediump float;\n"                                               \
+    "in vec2 fragTexCoord;\n"                                                  \
+    "out vec4 finalColor;\n"
+#define GLSL_TEXTURE "texture"
+#define GLSL_OUTPUT "finalColor"
+#elif defined(GRAPHICS_API_OPENGL_ES2)
+#define GLSL_HEADER                                                            \
+    "#version 100\n"                                                           \
+    "precision mediump float;\n"                                               \
+    "varying vec2 fragTexCoord;\n"
+#define GLSL_TEXTURE "texture2D"
+#define GLSL_OUTPUT "gl_FragColor"
+#elif defined(GRAPHICS_API_OPENGL_21) || defined(GRAPHICS_API_OPENGL_11)
+#define GLSL_HEADER                                                            \
+    "#version 120\n"                                                           \
+    "varying vec2 fragTexCoord;\n"
+#define GLSL_TEXTURE "texture2D"
+#define GLSL_OUTPUT "gl_FragColor"
+#else
+#define GLSL_HEADER                                                            \
+    "#version 330\n"                                                           \
+    "in vec2 fragTexCoord;\n"                                                  \
+    "out vec4 finalColor;\n"
+#define GLSL_TEXTURE "texture"
+#define GLSL_OUTPUT "finalColor"
+#endif
+
+// Effects are written as snippets defining `vec4 effect(vec2 uv)`, reading
+// the previous image through `sample_input(uv)`. Each pass wraps its effects
+// in this prelude and chains them by renaming those two functions, so a fused
+// effect samples the output of the one before it instead of a texture.
+static const char *PASS_PRELUDE = GLSL_HEADER
+    "uniform sampler2D texture0;\n"
+    "uniform vec2 u_resolution;\n"
+    "uniform float u_time;\n"
+    "vec4 fx_input0(vec2 uv) {\n"
+    "    return " GLSL_TEXTURE "(texture0, uv);\n"
+    "}\n";
+
+static const char *EFFECT_HEADER = "#define sample_input fx_input%d\n"
+                                   "#define effect fx_effect%d\n";
+
+static const char *EFFECT_FOOTER = "\n#undef effect\n"
+                                   "#undef sample_input\n"
+                                   "vec4 fx_input%d(vec2 uv) {\n"
+                                   "    return fx_effect%d(uv);\n"
+                                   "}\n";
+
+static const char *PASS_MAIN =
+    "void main() {\n"
+    "    " GLSL_OUTPUT " = fx_input%d(fragTexCoord);\n"
+    "}\n";
+
+// EFFECT_OVERHEAD bounds the length of the generated code around each effect.
+#define EFFECT_OVERHEAD 256
+
+// Is_fusable returns true if the effect samples its input at most once, so
+// running the previous effect in its place costs no more than a texture read.
+static bool is_fusable(const char *src) {
+    return strstr(src, "#pragma fusable") != NULL;
+}
+
+// Build_pass generates the source of a pass running `count` effects.
+static char *build_pass(const char *const *sources, int count) {
+    size_t size = strlen(PASS_PRELUDE) + EFFECT_OVERHEAD;
+    for (int i = 0; i < count; i++) {
+        size += strlen(sources[i]) + EFFECT_OVERHEAD;
+    }
+
+    char *src = malloc(size);
+    if (src == NULL)
+        return NULL;
+
+    size_t len = 0;
+    len += snprintf(src + len, size - len, "%s", PASS_PRELUDE);
+    for (int i = 0; i < count; i++) {
+        len += snprintf(src + len, size - len, EFFECT_HEADER, i, i);
+        len += snprintf(src + len, size - len, "%s", sources[i]);
+        len += snprintf(src + len, size - len, EFFECT_FOOTER, i + 1, i);
+    }
+    snprintf(src + len, size - len, PASS_MAIN, count);
+
+    return src;
+}
+
+// Add_pass compiles effects [first, first + count) into a new pass.
+static void add_pass(postfx_t *post, const char *const *sources, int first,
+                     int count) {
+    char *src = build_pass(sources + first, count);
+    if (src == NULL)
+        return;
+
+    Shader shader = LoadShaderFromMemory(0, src);
+    free(src);
+
+    if (shader.id == 0 || shader.id == rlGetShaderIdDefault()) {
+        printf("Failed to load post effect %s\n", post->effect_names[first]);
+        return;
+    }
+
+    postfx_pass_t *pass = post->passes + post->pass_count++;
+    *pass = (postfx_pass_t){
+        .shader = shader,
+        .time_loc = GetShaderLocation(shader, "u_time"),
+        .resolution_loc = GetShaderLocation(shader, "u_resolution"),
+        .first_effect = first,
+        .effect_count = count,
+    };
+    gpu_timer_init(&pass->timer);
+
+    Vector2 resolution = {(float)post->width, (float)post->height};
+    SetShaderValue(shader, pass->resolution_loc, &resolution,
+                   SHADER_UNIFORM_VEC2);
+}
+
+void postfx_load(postfx_t *post, int width, int height,
+                 const char *const *sources, const char *const *names,
+                 int count) {
+    memset(post, 0, sizeof(postfx_t));
+    if (count > SETTINGS_MAX_POST_SHADERS)
+        count = SETTINGS_MAX_POST_SHADERS;
+
+    post->width = width;
+    post->height = height;
+    post->effect_count = count;
+    memcpy(post->effect_names, names, count * sizeof(const char *));
+
+    int first = 0;
+    for (int i = 1; i <= count; i++) {
+        if (i == count || !is_fusable(sources[i])) {
+            add_pass(post, sources, first, i - first);
+            first = i;
+        }
+    }
+
+    // A single pass reads from the first target and draws to the screen, so
+    // the second one is only needed for longer chains.
+    int target_count = post->pass_count > 1 ? 2 : post->pass_count;
+    for (int i = 0; i < target_count; i++) {
+        post->targets[i] = LoadRenderTexture(width, height);
+    }
+}
+
+void postfx_unload(postfx_t *post) {
+    for (int i = 0; i < post->pass_count; i++) {
+        UnloadShader(post->passes[i].shader);
+        gpu_timer_free(&post->passes[i].timer);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        if (post->targets[i].id != 0)
+            UnloadRenderTexture(post->targets[i]);
+    }
+
+    memset(post, 0, sizeof(postfx_t));
+}
+
+void postfx_begin(postfx_t *post, Color clear) {
+    if (post->pass_count == 0)
+        return;
+
+    BeginTextureMode(post->targets[0]);
+    ClearBackground(clear);
+}
+
+void postfx_end(postfx_t *post, double time) {
+    if (post->pass_count == 0)
+        return;
+
+    EndTextureMode();
+
+    float f_time = (float)time;
+
+    // Render textures are stored upside-down, hence the negative height.
+    Rectangle source = {0, 0, (float)post->width, (float)-post->height};
+
+    for (int i = 0; i < post->pass_count; i++) {
+        postfx_pass_t *pass = post->passes + i;
+        bool last = i == post->pass_count - 1;
+
+        if (!last)
+            BeginTextureMode(post->targets[(i + 1) % 2]);
+
+        // Flush anything batched so only this pass lands inside the query.
+        rlDrawRenderBatchActive();
+        gpu_timer_begin(&pass->timer);
+
+        SetShaderValue(pass->shader, pass->time_loc, &f_time,
+                       SHADER_UNIFORM_FLOAT);
+        BeginShaderMode(pass->shader);
+        DrawTextureRec(post->targets[i % 2].texture, source, (Vector2){0, 0},
+                       WHITE);
+        EndShaderMode();
+        gpu_timer_end(&pass->timer);
+
+        if (!last)
+            EndTextureMode();
+    }
+}
+
+float postfx_cost(postfx_t *post) {
+    float total = -1.0f;
+    for (int i = 0; i < post->pass_count; i++) {
+        float ms = post->passes[i].timer.ms;
+        if (ms >= 0.0f)
+            total = (total < 0.0f ? 0.0f : total) + ms;
+    }
+
+    return total;
+}
@@ -0,0 +1,62 @@
+#ifndef RAYTRIS_POSTFX_H_
+#define RAYTRIS_POSTFX_H_
+
+#include <raylib.h>
+#include <stdbool.h>
+
+#include "gputimer.h"
+#include "settings.h" // SETTINGS_MAX_POST_SHADERS
+
+// Postfx_pass is one full-screen pass of the post-processing chain. A pass
+// runs one or more effects fused into a single shader.
+typedef struct postfx_pass {
+    Shader shader;
+    int time_loc;
+    int resolution_loc;
+
+    int first_effect;
+    int effect_count;
+
+    // Timer measures the GPU time of the pass. Its `ms` is negative when the
+    // backend has no timer queries or no result has come back yet.
+    gpu_timer_t timer;
+} postfx_pass_t;
+
+// Postfx is a chain of post-processing effects. The game is drawn into the
+// first of two render targets, and the passes ping-pong between them. The last
+// pass draws straight to the screen.
+typedef struct postfx {
+    postfx_pass_t passes[SETTINGS_MAX_POST_SHADERS];
+    int pass_count;
+
+    const char *effect_names[SETTINGS_MAX_POST_SHADERS];
+    int effect_count;
+
+    RenderTexture2D targets[2];
+    int width;
+    int height;
+} postfx_t;
+
+// Postfx_load builds the chain from the effect shader `sources`, in order.
+// Adjacent effects are fused into a single pass when the later one is marked
+// `#pragma fusable`. `names` are used in error messages and stats and must
+// outlive `post`.
+void postfx_load(postfx_t *post, int width, int height,
+                 const char *const *sources, const char *const *names,
+                 int count);
+
+// Postfx_unload releases the shaders and render targets of the chain.
+void postfx_unload(postfx_t *post);
+
+// Postfx_begin redirects drawing into the chain's first render target, cleared
+// to `clear`. It does nothing if the chain is empty.
+void postfx_begin(postfx_t *post, Color clear);
+
+// Postfx_end runs the chain and draws the result to the screen.
+void postfx_end(postfx_t *post, double time);
+
+// Postfx_cost returns the total smoothed GPU time of the chain in
+// milliseconds, or a negative value if none of its passes have been measured.
+float postfx_cost(postfx_t *post);
+
+#endif
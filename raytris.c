@@ -1,6 +1,8 @@
 #include "raytris.h"
 
 #include <raylib.h>
+#include <rlgl.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -45,7 +47,7 @@ void game_advance_piece(game_t *game) {
     if (game->bag_current >= TM_COUNT) {
         game->bag_current = 0;
         memcpy(game->bag, game->next_bag, TM_COUNT * sizeof(struct tetromino));
-        choose_sequence(game->next_bag);
+        choose_sequence(game->next_bag, &game->rng);
     }
 
     game->falling = game->bag[game->bag_current];
@@ -76,15 +78,15 @@ void game_swap_held_piece(game_t *game) {
     }
 }
 
-static void handle_shift(struct game *game, int key, int x_offset,
-                         double time) {
-    if (IsKeyPressed(key)) {
+static void handle_shift(struct game *game, input_t input, int button,
+                         int x_offset, double time) {
+    if (INPUT_PRESSED(input, button)) {
         game->move_start = time;
         if (!board_collides(&game->board, &game->falling,
                             game->falling_x + x_offset, game->falling_y)) {
             game->falling_x += x_offset;
         }
-    } else if (IsKeyDown(key) &&
+    } else if (INPUT_DOWN(input, button) &&
                time - game->move_start >= game->settings.das_delay) {
         if (time - game->last_das >= game->settings.das_rate) {
             if (!board_collides(&game->board, &game->falling,
@@ -96,13 +98,29 @@ static void handle_shift(struct game *game, int key, int x_offset,
     }
 }
 
+void game_seed(game_t *game, unsigned int seed) {
+    game->rng = seed;
+}
+
 void game_init(game_t *game) {
     game_reset(game);
     game_reload_shaders(game);
+
+    // Shaders are watched even when they were loaded from the archive, so
+    // edits to the loose files still show up in a development build.
+    const char *name = game->settings.bg_shader_name;
+    if (name != NULL && FileExists(name)) {
+        game->bg_watch = hotreload_start(name);
+    }
 }
 
-void game_reload_shaders(game_t *game) {
-    game->bg_shader = LoadShader(0, game->settings.bg_shader_name);
+// Use_bg_shader replaces the background shader with `shader`, releasing the
+// previous one, and looks up its uniforms.
+static void use_bg_shader(game_t *game, Shader shader) {
+    if (game->bg_shader.id != 0)
+        UnloadShader(game->bg_shader);
+    game->bg_shader = shader;
+    game->shader_info.uniforms_dirty = true;
 
 #define FIND_LOC(X)                                                            \
     game->shader_info.X##_loc = GetShaderLocation(game->bg_shader, "u_" #X);
@@ -116,15 +134,105 @@ void game_reload_shaders(game_t *game) {
 #undef FIND_LOC
 }
 
+// Reload_post_shaders rebuilds the post-processing chain from
+// `settings.post_shader_names`. Effects that can't be read are skipped.
+static void reload_post_shaders(game_t *game) {
+    const char *sources[SETTINGS_MAX_POST_SHADERS];
+    const char *names[SETTINGS_MAX_POST_SHADERS];
+    char *loaded[SETTINGS_MAX_POST_SHADERS];
+    int count = 0;
+
+    for (int i = 0; i < game->settings.post_shader_count; i++) {
+        const char *name = game->settings.post_shader_names[i];
+        const char *src = NULL;
+        loaded[count] = NULL;
+
+        if (game->resources != NULL) {
+            src = archive_find(game->resources, name, NULL);
+        }
+
+        if (src == NULL) {
+            src = loaded[count] = LoadFileText(name);
+        }
+
+        if (src == NULL) {
+            printf("Failed to read post effect %s\n", name);
+            continue;
+        }
+
+        sources[count] = src;
+        names[count] = name;
+        count++;
+    }
+
+    postfx_unload(&game->post);
+    postfx_load(&game->post, GetScreenWidth(), GetScreenHeight(), sources,
+                names, count);
+
+    for (int i = 0; i < count; i++) {
+        if (loaded[i] != NULL)
+            UnloadFileText(loaded[i]);
+    }
+}
+
+void game_reload_shaders(game_t *game) {
+    const char *name = game->settings.bg_shader_name;
+
+    const char *src = NULL;
+    if (game->resources != NULL && name != NULL) {
+        src = archive_find(game->resources, name, NULL);
+    }
+
+    if (src != NULL) {
+        use_bg_shader(game, LoadShaderFromMemory(0, src));
+    } else {
+        use_bg_shader(game, LoadShader(0, name));
+    }
+
+    reload_post_shaders(game);
+}
+
+void game_poll_shaders(game_t *game) {
+    if (game->bg_watch == NULL)
+        return;
+
+    char *src = hotreload_take(game->bg_watch);
+    if (src == NULL)
+        return;
+
+    Shader shader = LoadShaderFromMemory(0, src);
+    free(src);
+
+    // Raylib falls back to its default shader when compilation fails. Keep
+    // the current one instead so a typo doesn't blank the background.
+    if (shader.id == 0 || shader.id == rlGetShaderIdDefault()) {
+        printf("Failed to reload %s\n", game->settings.bg_shader_name);
+        return;
+    }
+
+    use_bg_shader(game, shader);
+}
+
 void game_free(game_t *game) {
+    if (game->bg_watch != NULL) {
+        hotreload_stop(game->bg_watch);
+        game->bg_watch = NULL;
+    }
+
     UnloadShader(game->bg_shader);
+    postfx_unload(&game->post);
+
+    if (game->bg_pass.target.id != 0) {
+        UnloadRenderTexture(game->bg_pass.target);
+        game->bg_pass.target = (RenderTexture2D){0};
+    }
 }
 
 void game_reset(game_t *game) {
     memset(&game->board, 0, sizeof(board_t));
 
-    choose_sequence(game->bag);
-    choose_sequence(game->next_bag);
+    choose_sequence(game->bag, &game->rng);
+    choose_sequence(game->next_bag, &game->rng);
 
     game->falling = game->bag[game->bag_current];
     game->falling_y = BOARD_VISIBLE;
@@ -141,23 +249,106 @@ void game_reset(game_t *game) {
 
     game->over = false;
 
+    game->tick = 0;
+    game->checksum = game_hash(game);
+
     game->shader_info.approx_height = 0;
     game->shader_info.over_time = 0;
 }
 
-bool game_update(game_t *game, double time) {
+// FNV_OFFSET and FNV_PRIME are the parameters of the 64-bit FNV-1a hash used
+// for game checksums.
+#define FNV_OFFSET 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+
+// Hash_int feeds `value` into the FNV-1a hash `h` as four little-endian bytes,
+// so the result is the same regardless of platform.
+static uint64_t hash_int(uint64_t h, int value) {
+    uint32_t v = (uint32_t)value;
+    for (int i = 0; i < 4; i++) {
+        h ^= (v >> (8 * i)) & 0xff;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static uint64_t hash_piece(uint64_t h, tetromino_t *piece) {
+    h = hash_int(h, piece->size);
+    for (int i = 0; i < piece->size; i++) {
+        for (int j = 0; j < piece->size; j++) {
+            h = hash_int(h, piece->shape[i][j]);
+        }
+    }
+    return h;
+}
+
+// Hash_state continues the hash `h` with the state described in game_hash.
+static uint64_t hash_state(game_t *game, uint64_t h) {
+    for (int j = 0; j < BOARD_HEIGHT; j++) {
+        for (int i = 0; i < BOARD_WIDTH; i++) {
+            h = hash_int(h, game->board.data[j][i]);
+        }
+    }
+
+    h = hash_piece(h, &game->falling);
+    h = hash_int(h, game->falling_x);
+    h = hash_int(h, game->falling_y);
+
+    h = hash_int(h, (int)game->rng);
+    h = hash_int(h, game->bag_current);
+    for (int i = 0; i < TM_COUNT; i++) {
+        h = hash_piece(h, game->bag + i);
+    }
+    for (int i = 0; i < TM_COUNT; i++) {
+        h = hash_piece(h, game->next_bag + i);
+    }
+
+    h = hash_int(h, game->has_held);
+    h = hash_int(h, game->used_hold);
+    if (game->has_held) {
+        h = hash_piece(h, &game->held);
+    }
+
+    return hash_int(h, game->over);
+}
+
+input_t game_read_input(game_t *game) {
+    bindings_t bindings = game->settings.bindings;
+    int keys[INPUT_BUTTON_COUNT] = {
+        [INPUT_SOFT_DROP] = bindings.key_soft_drop,
+        [INPUT_HARD_DROP] = bindings.key_hard_drop,
+        [INPUT_LEFT] = bindings.key_left,
+        [INPUT_RIGHT] = bindings.key_right,
+        [INPUT_ROTATE_CW] = bindings.key_rotate_cw,
+        [INPUT_ROTATE_CCW] = bindings.key_rotate_ccw,
+        [INPUT_HOLD] = bindings.key_hold,
+    };
+
+    input_t input = {0};
+    for (int i = 0; i < INPUT_BUTTON_COUNT; i++) {
+        if (IsKeyDown(keys[i]))
+            input.down |= 1u << i;
+        if (IsKeyPressed(keys[i]))
+            input.pressed |= 1u << i;
+    }
+
+    return input;
+}
+
+bool game_update(game_t *game, input_t input, double time) {
+    memset(&game->events, 0, sizeof(game_events_t));
+
     if (game->over)
         return false;
 
-    bindings_t bindings = game->settings.bindings;
     double actual_fall_rate = game->fall_rate;
 
-    if (IsKeyDown(bindings.key_soft_drop) &&
+    if (INPUT_DOWN(input, INPUT_SOFT_DROP) &&
         game->settings.fast_fall_rate < game->fall_rate) {
         actual_fall_rate = game->settings.fast_fall_rate;
     }
 
-    if (!game->used_hold && IsKeyPressed(bindings.key_hold)) {
+    if (!game->used_hold && INPUT_PRESSED(input, INPUT_HOLD)) {
         game_swap_held_piece(game);
         game->used_hold = true;
     }
@@ -174,7 +365,7 @@ bool game_update(game_t *game, double time) {
         }
     }
 
-    if (IsKeyPressed(bindings.key_hard_drop)) {
+    if (INPUT_PRESSED(input, INPUT_HARD_DROP)) {
         while (!board_collides(&game->board, &game->falling, game->falling_x,
                                game->falling_y + 1)) {
             game->falling_y++;
@@ -186,6 +377,12 @@ bool game_update(game_t *game, double time) {
     if (can_place) {
         board_place(&game->board, &game->falling, game->falling_x,
                     game->falling_y);
+
+        game->events.locked = true;
+        game->events.locked_piece = game->falling;
+        game->events.locked_x = game->falling_x;
+        game->events.locked_y = game->falling_y;
+
         game->shader_info.approx_height = max(BOARD_HEIGHT - game->falling_y,
                                               game->shader_info.approx_height);
 
@@ -200,6 +397,11 @@ bool game_update(game_t *game, double time) {
                     goto next_row;
             }
 
+            int cleared = game->events.cleared_count++;
+            game->events.cleared_rows[cleared] = j;
+            memcpy(game->events.cleared_blocks[cleared], game->board.data[j],
+                   sizeof(game->board.data[j]));
+
             board_clear(&game->board, j, j + 1);
             game->shader_info.approx_height--;
         next_row:;
@@ -209,11 +411,11 @@ bool game_update(game_t *game, double time) {
         game->used_hold = false;
     }
 
-    handle_shift(game, bindings.key_right, +1, time);
-    handle_shift(game, bindings.key_left, -1, time);
+    handle_shift(game, input, INPUT_RIGHT, +1, time);
+    handle_shift(game, input, INPUT_LEFT, -1, time);
 
-    bool cw = IsKeyPressed(bindings.key_rotate_cw);
-    bool ccw = IsKeyPressed(bindings.key_rotate_ccw);
+    bool cw = INPUT_PRESSED(input, INPUT_ROTATE_CW);
+    bool ccw = INPUT_PRESSED(input, INPUT_ROTATE_CCW);
 
     if (cw || ccw) {
         tetromino_t rotation_buf;
@@ -244,5 +446,12 @@ bool game_update(game_t *game, double time) {
         game->shader_info.over_time = (float)time;
     }
 
+    game->tick++;
+    game->checksum = hash_state(game, game->checksum);
+
     return true;
+}
+
+uint64_t game_hash(game_t *game) {
+    return hash_state(game, FNV_OFFSET);
 }
\ No newline at end of file
@@ -1,9 +1,15 @@
 #ifndef RAYTRIS_RAYTRIS_H_
 #define RAYTRIS_RAYTRIS_H_
 
+#include "archive.h"
+#include "hotreload.h"
+#include "particles.h"
+#include "postfx.h"
 #include "settings.h"
 #include "tetromino.h"
 
+#include <stdint.h>
+
 #define BOARD_WIDTH 10
 #define BOARD_HEIGHT 40
 
@@ -33,15 +39,60 @@ void board_place(board_t *board, tetromino_t *piece, int x, int y);
 // boundaries.
 bool board_collides(board_t *board, tetromino_t *piece, int x, int y);
 
+// Input_button identifies one of the controls that affect the game.
+typedef enum input_button {
+    INPUT_SOFT_DROP,
+    INPUT_HARD_DROP,
+    INPUT_LEFT,
+    INPUT_RIGHT,
+    INPUT_ROTATE_CW,
+    INPUT_ROTATE_CCW,
+    INPUT_HOLD,
+    INPUT_BUTTON_COUNT
+} input_button_t;
+
+// Input is the state of the controls for one update. `Down` and `pressed` are
+// bitmasks indexed by input_button_t of the controls that are held and that
+// were pressed since the last update, respectively.
+typedef struct input {
+    unsigned int down;
+    unsigned int pressed;
+} input_t;
+
+#define INPUT_DOWN(I, B) ((((I).down) >> (B)) & 1u)
+#define INPUT_PRESSED(I, B) ((((I).pressed) >> (B)) & 1u)
+
+// Game_events records what happened during the last call to game_update, so
+// that effects can react to it. It is not part of the game's state.
+typedef struct game_events {
+    bool locked;
+    tetromino_t locked_piece;
+    int locked_x;
+    int locked_y;
+
+    // Cleared_blocks holds the contents of each cleared row before it was
+    // removed.
+    int cleared_count;
+    int cleared_rows[TM_MAX_SIZE];
+    int cleared_blocks[TM_MAX_SIZE][BOARD_WIDTH];
+} game_events_t;
+
 // Game is the main game data structure.
 typedef struct game {
     settings_t settings;
+
+    // Resources is the packed resource archive, or NULL if resources are read
+    // from loose files.
+    const archive_t *resources;
     board_t board;
 
     tetromino_t bag[TM_COUNT];
     tetromino_t next_bag[TM_COUNT];
     int bag_current;
 
+    // Rng is the state of the generator that shuffles the bags.
+    uint32_t rng;
+
     tetromino_t falling;
     int falling_x;
     int falling_y;
@@ -57,7 +108,17 @@ typedef struct game {
 
     bool over;
 
+    // Tick counts calls to game_update that advanced the game. Checksum is a
+    // rolling hash of the state after each of those ticks, so two runs given
+    // the same seed and inputs match tick for tick.
+    uint64_t tick;
+    uint64_t checksum;
+
+    game_events_t events;
+    particles_t particles;
+
     Shader bg_shader;
+    hotreload_t *bg_watch;
     struct shader_info {
         int time_loc;
         int over_time_loc;
@@ -67,7 +128,31 @@ typedef struct game {
 
         int approx_height;
         float over_time;
+
+        // Uniforms_dirty is set when uniforms that rarely change (resolution
+        // and block size) need to be uploaded again.
+        bool uniforms_dirty;
     } shader_info;
+
+    // Bg_pass holds the reduced-resolution target the background shader is
+    // rendered into before being upscaled to the screen. The target is only
+    // allocated while the resolution is actually reduced. Scale_level indexes
+    // into the list of scales in graphics.c and is adjusted at runtime to keep
+    // frame time within `settings.frame_budget`. Sharpest_level is the
+    // sharpest level it may return to, raised whenever probing a sharper level
+    // goes over budget for a sustained period.
+    struct bg_pass {
+        RenderTexture2D target;
+        int scale_level;
+        int sharpest_level;
+        bool probing;
+        float frame_time;
+        int over_frames;
+        double level_changed;
+    } bg_pass;
+
+    postfx_t post;
+    bool show_stats;
 } game_t;
 
 // Game_advance_piece updates `falling` with the next piece in the queue. If
@@ -80,8 +165,14 @@ void game_advance_piece(game_t *game);
 // used to select the next piece.
 void game_swap_held_piece(game_t *game);
 
+// Game_seed seeds the generator that chooses the piece sequence. It takes
+// effect from the next bag, so it should be called before game_init to cover
+// the whole game.
+void game_seed(game_t *game, unsigned int seed);
+
 // Game_init sets the state of the given `game` to reasonable defaults. It also
-// loads the background shader if one is specified.
+// loads the background shader if one is specified, and watches its loose file
+// for changes if there is one.
 void game_init(game_t *game);
 
 // Game_reset resets a game to its default state.
@@ -90,10 +181,25 @@ void game_reset(game_t *game);
 // Game_reload_shaders reloads game shaders.
 void game_reload_shaders(game_t *game);
 
-// Game_update handles input and updates the current game. It returns false if
-// the game has ended.
-bool game_update(game_t *game, double time);
+// Game_poll_shaders swaps in the background shader if its file has changed
+// since the last call. It should be called between frames.
+void game_poll_shaders(game_t *game);
+
+// Game_read_input reads the state of the game's controls from the keyboard.
+input_t game_read_input(game_t *game);
+
+// Game_update applies `input` and updates the current game, recording piece
+// locks and line clears in `events`. It returns false if the game has ended.
+// Given the same seed, inputs and times, it always produces the same sequence
+// of states.
+bool game_update(game_t *game, input_t input, double time);
 
 void game_free(game_t *game);
 
+// Game_hash returns a 64-bit hash of the state that determines how the game
+// plays out: the board, the falling piece and its position, the queue, the
+// held piece and the state of the piece generator. It depends only on the
+// values of that state, not on how it is laid out in memory.
+uint64_t game_hash(game_t *game);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "recording.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+// RECORDING_MAGIC begins the header line of every recording.
+#define RECORDING_MAGIC "raytris-recording 2"
+
+// RECORDING_HEADER builds the format of the rest of the header line: the
+// seed, then the settings that affect play. Doubles are converted with
+// `dbl`, which is .17g when writing, so that they round-trip exactly, and lg
+// when reading.
+#define RECORDING_HEADER(dbl)                                                  \
+    " seed %u fast_fall_rate %" dbl " das_delay %" dbl " das_rate %" dbl
+
+void recording_begin(FILE *rec, unsigned int seed, settings_t *settings) {
+    fprintf(rec, RECORDING_MAGIC RECORDING_HEADER(".17g") "\n", seed,
+            settings->fast_fall_rate, settings->das_delay, settings->das_rate);
+}
+
+void recording_tick(FILE *rec, game_t *game, input_t input, double time) {
+    // %.17g round-trips doubles exactly, so replays see the same times.
+    fprintf(rec, "tick %" PRIu64 " %.17g %u %u %016" PRIx64 "\n", game->tick,
+            time, input.down, input.pressed, game->checksum);
+}
+
+void recording_reset(FILE *rec) {
+    fprintf(rec, "reset\n");
+}
+
+bool recording_replay(const char *path, FILE *out) {
+    FILE *rec = fopen(path, "r");
+    if (rec == NULL)
+        return false;
+
+    // Replays use the recorded settings rather than whatever raytris.ini the
+    // replaying build finds, so a settings change can't look like divergence.
+    settings_t settings = SETTINGS_DEFAULT;
+    unsigned int seed;
+    if (fscanf(rec, RECORDING_MAGIC RECORDING_HEADER("lg") "\n", &seed,
+               &settings.fast_fall_rate, &settings.das_delay,
+               &settings.das_rate) != 4) {
+        fclose(rec);
+        return false;
+    }
+
+    if (out != NULL)
+        recording_begin(out, seed, &settings);
+
+    // The game is large because of its particle pool, so keep it off the
+    // stack.
+    static game_t game;
+    memset(&game, 0, sizeof(game_t));
+    game.settings = settings;
+
+    game_seed(&game, seed);
+    game_reset(&game);
+
+    char line[256];
+    while (fgets(line, sizeof(line), rec) != NULL) {
+        if (strncmp(line, "reset", 5) == 0) {
+            game_reset(&game);
+            if (out != NULL)
+                recording_reset(out);
+            continue;
+        }
+
+        uint64_t tick;
+        double time;
+        input_t input;
+        if (sscanf(line, "tick %" SCNu64 " %lg %u %u", &tick, &time,
+                   &input.down, &input.pressed) != 4)
+            continue;
+
+        if (game_update(&game, input, time) && out != NULL)
+            recording_tick(out, &game, input, time);
+    }
+
+    fclose(rec);
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef RAYTRIS_RECORDING_H_
+#define RAYTRIS_RECORDING_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "raytris.h"
+
+// Recordings are text files that capture a run of the game well enough to
+// replay it. After a header naming the random seed and the settings that
+// affect play, each update that advanced the game is written as
+//
+//     tick <tick> <time> <down> <pressed> <checksum>
+//
+// and restarts are written as `reset`. Scripts/diverge.py compares the
+// checksums of two recordings.
+
+// Recording_begin writes the header of a recording of a game seeded with
+// `seed` and played with `settings`.
+void recording_begin(FILE *rec, unsigned int seed, settings_t *settings);
+
+// Recording_tick records the update of `game` that was just made with `input`
+// at `time`.
+void recording_tick(FILE *rec, game_t *game, input_t input, double time);
+
+// Recording_reset records a restart of the game.
+void recording_reset(FILE *rec);
+
+// Recording_replay replays the recording at `path` with the settings it was
+// recorded with, without a window. If `out` is not NULL, the replayed run is
+// recorded to it, so it can be compared with the original. It returns false if
+// the recording can't be read.
+bool recording_replay(const char *path, FILE *out);
+
+#endif
@@ -0,0 +1,23 @@
+// Bloom: bright areas bleed light into their surroundings. This samples its
+// input many times, so it always starts a new pass.
+
+float bloom_threshold = 0.6;
+float bloom_strength = 0.8;
+
+vec4 effect(vec2 uv) {
+    vec4 color = sample_input(uv);
+    vec2 texel = 1.0 / u_resolution;
+
+    vec3 glow = vec3(0.0);
+    float total = 0.0;
+    for (int x = -3; x <= 3; x++) {
+        for (int y = -3; y <= 3; y++) {
+            vec3 s = sample_input(uv + 2.0 * texel * vec2(x, y)).rgb;
+            float weight = 1.0 / (1.0 + float(x * x + y * y));
+            glow += max(s - bloom_threshold, 0.0) * weight;
+            total += weight;
+        }
+    }
+
+    return vec4(color.rgb + bloom_strength * glow / total, color.a);
+}
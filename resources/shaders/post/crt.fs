@@ -0,0 +1,24 @@
+#pragma fusable
+
+// CRT: screen curvature, scanlines and a vignette. It reads its input once, so
+// it can share a pass with the effect before it.
+
+float crt_curvature = 0.08;
+float crt_scanline_strength = 0.15;
+
+vec4 effect(vec2 uv) {
+    vec2 centered = uv * 2.0 - 1.0;
+    centered *= 1.0 + crt_curvature * dot(centered, centered);
+    vec2 curved = centered * 0.5 + 0.5;
+
+    if (curved.x < 0.0 || curved.x > 1.0 || curved.y < 0.0 || curved.y > 1.0)
+        return vec4(0.0, 0.0, 0.0, 1.0);
+
+    vec4 color = sample_input(curved);
+
+    float scanline = sin(curved.y * u_resolution.y * 3.14159);
+    color.rgb *= 1.0 - crt_scanline_strength * scanline * scanline;
+    color.rgb *= 1.0 - 0.3 * dot(centered, centered);
+
+    return color;
+}
@@ -0,0 +1,17 @@
+#pragma fusable
+
+// Color grading: lifts shadows, warms highlights and boosts saturation.
+
+vec3 grade_shadows = vec3(0.02, 0.0, 0.04);
+vec3 grade_highlights = vec3(1.05, 1.0, 0.95);
+float grade_saturation = 1.2;
+
+vec4 effect(vec2 uv) {
+    vec4 color = sample_input(uv);
+
+    vec3 graded = grade_shadows + color.rgb * grade_highlights;
+    float luma = dot(graded, vec3(0.299, 0.587, 0.114));
+    graded = mix(vec3(luma), graded, grade_saturation);
+
+    return vec4(clamp(graded, 0.0, 1.0), color.a);
+}
@@ -0,0 +1,43 @@
+# Reports the first tick at which two raytris recordings disagree.
+#
+# Usage: python diverge.py <a.rec> <b.rec>
+#
+# To check another build against a reference run, replay the reference
+# recording with it and compare the two:
+#
+#   raytris --replay a.rec --record b.rec
+#   python diverge.py a.rec b.rec
+
+import sys
+
+
+def read_ticks(path):
+    ticks = []
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if fields and fields[0] == 'reset':
+                ticks.append(('reset', None))
+            elif fields and fields[0] == 'tick':
+                ticks.append((int(fields[1]), fields[5]))
+    return ticks
+
+
+if len(sys.argv) != 3:
+    print('Usage: diverge.py <a.rec> <b.rec>')
+    sys.exit(2)
+
+a = read_ticks(sys.argv[1])
+b = read_ticks(sys.argv[2])
+
+for i, (x, y) in enumerate(zip(a, b)):
+    if x != y:
+        print(f'First divergence at tick {x[0]} (entry {i}): {x[1]} vs {y[1]}')
+        sys.exit(1)
+
+if len(a) != len(b):
+    shorter = sys.argv[1] if len(a) < len(b) else sys.argv[2]
+    print(f'{shorter} ends after {min(len(a), len(b))} entries')
+    sys.exit(1)
+
+print(f'Identical for {len(a)} entries')
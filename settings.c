@@ -40,6 +40,11 @@ static int ini_callback(void *user, const char *section, const char *name,
         if (KEY_IS("background")) {
             settings->bg_shader_name = _strdup(value);
         }
+        if (KEY_IS("post") &&
+            settings->post_shader_count < SETTINGS_MAX_POST_SHADERS) {
+            settings->post_shader_names[settings->post_shader_count++] =
+                _strdup(value);
+        }
     }
 
     return 0;
@@ -54,10 +59,15 @@ int settings_load(settings_t *s, const char *path) {
     return ini_parse(path, &ini_callback, (void *)s);
 }
 
+int settings_load_string(settings_t *s, const char *text) {
+    return ini_parse_string(text, &ini_callback, (void *)s);
+}
+
 const settings_t SETTINGS_DEFAULT = {
     .fast_fall_rate = 0.1,
     .das_delay = 0.12,
     .das_rate = 0.01,
+    .frame_budget = 1.0 / 60.0,
 
     .palette =
         {
@@ -75,6 +85,7 @@ const settings_t SETTINGS_DEFAULT = {
             .key_rotate_ccw = KEY_Z,
             .key_hold = KEY_C,
             .key_reset = KEY_Q,
+            .key_stats = KEY_F3,
         },
 
     .bg_shader_name = NULL  // Raylib will interpret this as "no shader"
@@ -5,6 +5,9 @@
 
 #include <raylib.h>
 
+// SETTINGS_MAX_POST_SHADERS is the maximum length of the post-processing chain.
+#define SETTINGS_MAX_POST_SHADERS 8
+
 typedef struct bindings {
     int key_soft_drop;
     int key_hard_drop;
@@ -14,6 +17,7 @@ typedef struct bindings {
     int key_rotate_ccw;
     int key_hold;
     int key_reset;
+    int key_stats;
 } bindings_t;
 
 typedef struct palette {
@@ -28,14 +32,26 @@ typedef struct settings {
     double das_delay;
     double das_rate;
 
+    // Frame_budget is the target frame time in seconds. The background pass
+    // lowers its resolution when frames take longer than this.
+    double frame_budget;
+
     palette_t palette;
     bindings_t bindings;
 
     const char* bg_shader_name;
+
+    // Post_shader_names lists the post-processing effects to apply, in order.
+    const char* post_shader_names[SETTINGS_MAX_POST_SHADERS];
+    int post_shader_count;
 } settings_t;
 
 extern const settings_t SETTINGS_DEFAULT;
 
 int settings_load(settings_t* s, const char* path);
 
+// Settings_load_string is like settings_load, but parses the contents of an
+// ini file already in memory.
+int settings_load_string(settings_t* s, const char* text);
+
 #endif
\ No newline at end of file
@@ -1,7 +1,7 @@
-#include <raylib.h>
-
 #include "tetromino.h"
 
+#include "xorshift.h"
+
 void tetromino_rotate(tetromino_t *src, tetromino_t *dst, enum direction dir) {
     int size = src->size;
     dst->size = size;
@@ -34,7 +34,7 @@ void tetromino_rotate(tetromino_t *src, tetromino_t *dst, enum direction dir) {
     }
 }
 
-void choose_sequence(struct tetromino bag[TM_COUNT]) {
+void choose_sequence(struct tetromino bag[TM_COUNT], uint32_t *rng) {
     int indices[TM_COUNT];
     for (int i = 0; i < TM_COUNT; i++) {
         indices[i] = i;
@@ -42,7 +42,7 @@ void choose_sequence(struct tetromino bag[TM_COUNT]) {
 
     if (TM_COUNT > 1) {
         for (int i = TM_COUNT - 1; i > 0; i--) {
-            int j = GetRandomValue(0, i);
+            int j = (int)(xorshift32(rng) % (uint32_t)(i + 1));
             int t = indices[j];
             indices[j] = indices[i];
             indices[i] = t;
@@ -1,6 +1,8 @@
 #ifndef RAYTRIS_TETROMINO_H_
 #define RAYTRIS_TETROMINO_H_
 
+#include <stdint.h>
+
 // TM_COUNT defines how many tetrominoes there are.
 #define TM_COUNT 7
 
@@ -23,7 +25,9 @@ typedef enum direction { CLOCKWISE, COUNTERCLOCKWISE } direction_t;
 // src and dst can be the same array.
 void tetromino_rotate(tetromino_t *src, tetromino_t *dst, direction_t dir);
 
-// Choose_sequence places all pieces into bag in a random order.
-void choose_sequence(tetromino_t bag[TM_COUNT]);
+// Choose_sequence places all pieces into bag in a random order, drawn from the
+// generator state `rng`. The order depends only on `rng`, so it is the same on
+// every platform and compiler.
+void choose_sequence(tetromino_t bag[TM_COUNT], uint32_t *rng);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "xorshift.h"
+
+uint32_t xorshift32(uint32_t *state) {
+    uint32_t s = *state != 0 ? *state : 0x9e3779b9u;
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    *state = s;
+    return s;
+}
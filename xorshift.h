@@ -0,0 +1,11 @@
+#ifndef RAYTRIS_XORSHIFT_H_
+#define RAYTRIS_XORSHIFT_H_
+
+#include <stdint.h>
+
+// Xorshift32 advances the xorshift32 generator `state` and returns its new
+// value. A zero state would never change, so it is replaced first. The
+// sequence depends only on `state`, so it is the same on every platform.
+uint32_t xorshift32(uint32_t *state);
+
+#endif